@@ -0,0 +1,248 @@
+#!/usr/bin/env bash
+# Fixed-seed benchmark of the bundled networks.
+#
+#   scripts/bench.sh            run, and compare with the reference build
+#   scripts/bench.sh --save     run, and store the counts as the baseline
+#   scripts/bench.sh --phases   also run with timing on and show the phases
+#
+# Times from another machine mean nothing here, so the first step is to
+# build a reference revision from git into a scratch directory, and every
+# workload is timed with both builds on this machine.  The reference is
+# BENCH_REF if set (none skips the comparison), else the revision named in
+# bench_baseline.txt, the one the tree started from, else the merge-base
+# with main.  If none of them is there or it does not build, bench.sh
+# stops.  The baseline file keeps only the reference and the patterns and
+# cycles each workload runs, which do not depend on the machine; a run
+# whose counts differ is marked.
+#
+# Each workload is run BENCH_RUNS times (default 5) and the fastest run is
+# kept.  Runs are timed by the CPU time they take, so a reference from
+# before batch mode, which is run the old way and pauses at start-up, is
+# timed fairly.  Pattern and cycle counts come from the programs' own
+# phase counters (save timers), so the rates do not depend on what the
+# command files happen to ask for.
+set -euo pipefail
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+baseline="$repo_root/scripts/bench_baseline.txt"
+runs="${BENCH_RUNS:-5}"
+save=0
+phases=0
+for arg in "$@"; do
+  case "$arg" in
+    --save) save=1 ;;
+    --phases) phases=1 ;;
+    *) echo "usage: $0 [--save] [--phases]"; exit 2 ;;
+  esac
+done
+
+work_dir="$(mktemp -d)"
+trap 'rm -rf "$work_dir"' EXIT
+results="$work_dir/results"
+: > "$results"
+
+stored_ref="$(awk '$1 == "ref" { print $2 }' "$baseline" 2> /dev/null)"
+is_rev() { git -C "$repo_root" rev-parse -q --verify "$1^{commit}" > /dev/null 2>&1; }
+
+ref="${BENCH_REF:-}"
+if [ -z "$ref" ]; then
+  if [ -n "$stored_ref" ] && is_rev "$stored_ref"; then
+    ref="$stored_ref"
+  else
+    for main in main origin/main; do
+      if is_rev "$main"; then
+        ref="$(git -C "$repo_root" merge-base HEAD "$main")" && break
+      fi
+    done
+  fi
+fi
+ref_root=""
+ref_flag=""
+if [ "$ref" != none ]; then
+  if [ -z "$ref" ] || ! is_rev "$ref"; then
+    echo "bench: no reference revision (${ref:-${stored_ref:-none}} is not in this" \
+      "repository); set BENCH_REF to one, or to none to skip the comparison" >&2
+    exit 1
+  fi
+  ref_root="$work_dir/ref"
+  mkdir "$ref_root"
+  if ! { git -C "$repo_root" archive "$ref" | tar -x -C "$ref_root" &&
+         (cd "$ref_root/src" && make linux_compat_links && make progs); } \
+       > "$work_dir/ref.log" 2>&1; then
+    echo "bench: the reference $ref does not build:" >&2
+    tail -n 20 "$work_dir/ref.log" >&2
+    exit 1
+  fi
+  # programs from before batch mode take the template and commands alone
+  if grep -q headless "$ref_root/src/MAIN.C"; then ref_flag=-b; fi
+  echo "reference: $(git -C "$repo_root" rev-parse --short "$ref")"
+fi
+
+# best_time ROOT DIR PROGRAM FLAG TEMPLATE COMMANDS: the least CPU time
+# taken by one of the runs, in ns
+best_time() {
+  local best="" t ns i TIMEFORMAT='%3U %3S'
+  for ((i = 0; i < runs; i++)); do
+    t=$( { time (cd "$1/$2" && "./$3" ${4:+"$4"} "$5" "$6" \
+                   > /dev/null 2>&1 < /dev/null); } 2>&1 )
+    ns=$(awk -v t="$t" 'BEGIN { split(t, f, " "); printf "%d", (f[1] + f[2]) * 1e9 }')
+    if [ -z "$best" ] || [ "$ns" -lt "$best" ]; then best=$ns; fi
+  done
+  echo "$best"
+}
+
+# bench NAME DIR PROGRAM TEMPLATE PATTERN_PHASE CYCLE_PHASE < commands
+# The phases named are entered once per pattern and once per cycle; - means
+# the workload has no such unit.
+bench() {
+  local name="$1" dir="$2" prog="$3" tem="$4" pphase="$5" cphase="$6"
+  local cmd="$work_dir/$name.cmd" timers="$work_dir/$name.timers"
+  local refcmd="$work_dir/$name.ref" best refbest=- pats cycles
+
+  # the reference may predate save timers, so it gets the bare commands
+  { cat; printf 'quit\ny\n'; } > "$refcmd"
+  { sed '$d' "$refcmd" | sed '$d'; printf 'save timers %s\nquit\ny\n' "$timers"; } > "$cmd"
+  best=$(best_time "$repo_root" "$dir" "$prog" -b "$tem" "$cmd")
+  if [ ! -s "$timers" ]; then
+    echo "bench: $name did not finish" >&2
+    exit 1
+  fi
+  if [ -n "$ref_root" ]; then
+    refbest=$(best_time "$ref_root" "$dir" "$prog" "$ref_flag" "$tem" "$refcmd")
+  fi
+  pats=$(awk -v c="$pphase" '$1 == c { print $2 }' "$timers")
+  cycles=$(awk -v c="$cphase" '$1 == c { print $2 }' "$timers")
+  echo "$name $best ${pats:--} ${cycles:--} $refbest" >> "$results"
+
+  if [ "$phases" = 1 ]; then
+    sed -i '1i set env timing 1' "$cmd"
+    (cd "$repo_root/$dir" && "./$prog" -b "$tem" "$cmd" > /dev/null 2>&1 < /dev/null)
+    awk -v n="$name" '$3 > 0 { printf "    %-12s %-10s %10d %10.4f s\n", n, $1, $2, $3 }' \
+      "$timers" | sort -k4 -rn
+  fi
+}
+
+bench bp-424 bp bp 424.TEM forward - << 'EOF'
+get network 424.NET
+get patterns 424.PAT
+set seed 1
+reset
+set ecrit 0
+set nepochs 150000
+ptrain
+EOF
+
+bench bp-XOR bp bp XOR.TEM forward - << 'EOF'
+get network XOR.NET
+get patterns XOR.PAT
+set seed 1
+reset
+set nepochs 300000
+ptrain
+EOF
+
+bench bp-REC bp bp REC.TEM forward - << 'EOF'
+get network REC.NET
+get patterns REC.PAT
+set seed 1
+reset
+set nepochs 100000
+strain
+EOF
+
+bench cs-CUBE cs cs CUBE.TEM - rupdate << 'EOF'
+get network CUBE.NET
+get weights CUBE.WTS
+set mode clamp 0
+set param estr .4
+set param istr .4
+get annealing 2 100000 .05 end
+set seed 1
+set ncycles 200000
+reset
+cycle
+EOF
+
+bench iac-JETS iac iac JETS.TEM - getnet << 'EOF'
+set param max 1.0
+set param min -.2
+set param rest -.1
+set param alpha .1
+set param gamma .1
+set param decay .1
+set param estr .4
+get network JETS.NET
+get unames Jets Sharks in20s in30s in40s JH HS College Single Married Divorced Pusher Burglar Bookie Art Al Sam Clyde Mike Jim Greg John Doug Lance George Pete Fred Gene Ralph Phil Ike Nick Don Ned Karl Ken Earl Rick Ol Neal Dave _Art _Al _Sam _Clyde _Mike _Jim _Greg _John _Doug _Lance _George _Pete _Fred _Gene _Ralph _Phil _Ike _Nick _Don _Ned _Karl _Ken _Earl _Rick _Ol _Neal _Dave end
+set ncycles 400000
+input n Art 1 Jets 0.5 end
+cycle
+EOF
+
+bench aa-DR8 aa aa DR8.TEM error getnet << 'EOF'
+set conf nunits 8
+set mode linear 1
+set param estr 1.0
+set param istr 1.0
+set param decay 1.0
+set param lrate .05
+set ncycles 2
+get patterns DR8.PAT
+set seed 1
+set ecrit 0
+set nepochs 200000
+ptrain
+EOF
+
+bench pa-JETS pa pa JETS.TEM forward - << 'EOF'
+get network JETS.NET
+get patterns JETS.PAT
+set seed 1
+reset
+set mode cs 1
+set nepochs 20000
+ptrain
+EOF
+
+bench ia ia ia IA.TEM - interact << 'EOF'
+do IA.PAR 1
+set mode comprp 2
+set ncycles 6000
+trial 1 TR*P end
+cycle
+set ncycles 6000
+trial 1 CAVE end
+cycle
+EOF
+
+awk -v basefile="$baseline" '
+  BEGIN {
+    while ((getline line < basefile) > 0) {
+      if (line ~ /^#/ || line ~ /^ref /) continue
+      split(line, f, " ")
+      counts[f[1]] = f[2] " " f[3]
+    }
+    printf "%-10s %9s %13s %13s %9s %8s\n",
+      "workload", "seconds", "patterns/s", "cycles/s", "reference", "speedup"
+  }
+  function rate(n, s) { return (n == "-") ? "-" : sprintf("%.0f", n / s) }
+  {
+    s = $2 / 1e9
+    b = ($5 == "-") ? "-" : sprintf("%.3f", $5 / 1e9)
+    x = ($5 == "-") ? "-" : sprintf("%.2fx", $5 / $2)
+    m = ($1 in counts && counts[$1] != $3 " " $4) ? "  counts differ" : ""
+    printf "%-10s %9.3f %13s %13s %9s %8s%s\n", $1, s, rate($3, s), rate($4, s), b, x, m
+  }' "$results"
+
+if [ "$save" = 1 ]; then
+  {
+    echo "# workload patterns cycles, and the revision timed for comparison"
+    echo "# (scripts/bench.sh --save; BENCH_REF=rev overrides the reference)"
+    if [ -n "$ref_root" ]; then
+      echo "ref $(git -C "$repo_root" rev-parse "$ref")"
+    else
+      echo "ref $stored_ref"
+    fi
+    awk '{ print $1, $3, $4 }' "$results"
+  } > "$baseline"
+  echo "baseline saved to $baseline"
+fi
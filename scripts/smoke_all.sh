@@ -5,5 +5,6 @@ repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
 
 "$repo_root/scripts/smoke_bp.sh"
 "$repo_root/scripts/smoke_pa.sh"
+"$repo_root/scripts/smoke_batch.sh"
 
 echo "All smoke tests passed"
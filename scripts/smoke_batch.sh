@@ -0,0 +1,52 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+out_file="/tmp/renewedpdp_batch_smoke.csv"
+log_file="/tmp/renewedpdp_batch_smoke.log"
+cmd_file="$(mktemp)"
+trap 'rm -f "$cmd_file"' EXIT
+rm -f "$log_file"
+
+cat > "$cmd_file" << EOF
+get
+network
+XOR.NET
+get
+patterns
+XOR.PAT
+set dlevel 3
+set slevel 3
+log $log_file
+set seed 5
+reset
+set nepochs 20
+strain
+quit
+y
+EOF
+
+cd "$repo_root/bp"
+./bp -b -s "$out_file" XOR.TEM "$cmd_file"
+
+if ! head -n 1 "$out_file" | grep -q "^epochno,patno,cycleno,tss,pss,gcor$"; then
+  echo "Batch smoke test failed: bad stream header"
+  head -n 5 "$out_file"
+  exit 1
+fi
+
+if ! tail -n 1 "$out_file" | grep -q "^20,"; then
+  echo "Batch smoke test failed: expected a record for epoch 20"
+  tail -n 5 "$out_file"
+  exit 1
+fi
+
+# the log gets the logged templates even with no screen
+if ! tail -n 1 "$log_file" 2> /dev/null | grep -q "^ *20 "; then
+  echo "Batch smoke test failed: expected epoch 20 in the log"
+  tail -n 5 "$log_file" 2> /dev/null
+  exit 1
+fi
+
+echo "Batch smoke test passed"
+tail -n 2 "$out_file"